@@ -0,0 +1,46 @@
+#!/bin/sh
+# Regression corpus runner: replays every puzzle in corpus/puzzles through
+# the check, solve, and count pipelines and diffs stdout against the golden
+# files in corpus/golden. Check and solve run under both validation kernels
+# (--mode=fused and --mode=threaded) so a divergence between them fails the
+# run even when both differ from an old golden the same way.
+#
+# Usage: corpus/run.sh [path-to-sudoku-binary]   (default ./sudoku)
+# Exits non-zero on the first missing golden or output mismatch count > 0.
+
+SUDOKU=${1:-./sudoku}
+CORPUS=$(dirname "$0")
+fails=0
+cases=0
+
+run_case() {
+    label=$1
+    golden=$2
+    shift 2
+    cases=$((cases + 1))
+    if [ ! -f "$golden" ]; then
+        echo "FAIL $label: missing golden $golden"
+        fails=$((fails + 1))
+        return
+    fi
+    if ! "$@" | diff -q - "$golden" > /dev/null; then
+        echo "FAIL $label"
+        "$@" | diff - "$golden" | head -5
+        fails=$((fails + 1))
+    fi
+}
+
+for puzzle in "$CORPUS"/puzzles/*.txt; do
+    name=$(basename "$puzzle" .txt)
+    for mode in fused threaded; do
+        run_case "$name check ($mode)" "$CORPUS/golden/$name.check" \
+            "$SUDOKU" --mode=$mode --quiet "$puzzle"
+        run_case "$name solve ($mode)" "$CORPUS/golden/$name.solve" \
+            "$SUDOKU" --mode=$mode --solve "$puzzle"
+    done
+    run_case "$name count" "$CORPUS/golden/$name.count" \
+        "$SUDOKU" --count-solutions "$puzzle"
+done
+
+echo "corpus: $cases cases, $fails failures"
+[ "$fails" -eq 0 ]
@@ -0,0 +1,132 @@
+/**
+ * @file sudoku.h
+ * @brief Public API of the Sudoku validation/solver engine.
+ *
+ * Everything here is implemented in sudoku_engine.c and linkable as
+ * libsudoku.a, so services can embed the validator and solver directly on
+ * in-memory grids instead of exec'ing the binary with a file path. Grids
+ * are 1-based: grid[1][1] is the top-left cell, grid[psize][psize] the
+ * bottom-right, cells are 0 when empty.
+ */
+
+#ifndef SUDOKU_H
+#define SUDOKU_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/* ---- grid lifecycle and I/O ---- */
+
+// one contiguous cache-line-aligned cell block behind a row-pointer view;
+// grids are recycled through a size-class pool, so delete releases rather
+// than frees and a steady-state batch allocates nothing
+int **allocateSudokuGrid(int psize);
+void deleteSudokuPuzzle(int psize, int **grid);
+
+// text or binary (magic-sniffed) puzzle file -> freshly allocated grid
+int readSudokuPuzzle(char *filename, int ***grid);
+void writeSudokuPuzzleBinary(char *filename, int psize, int **grid);
+
+void printSudokuPuzzle(int psize, int **grid);
+void fprintSudokuPuzzle(FILE *fp, int psize, int **grid);
+// suppress printSudokuPuzzle output entirely (verdict-only runs)
+void sudokuSetQuietOutput(bool quiet);
+
+/* ---- validation ---- */
+
+enum validationMode { VALIDATION_AUTO, VALIDATION_THREADED, VALIDATION_FUSED };
+
+void sudokuSetValidationMode(enum validationMode mode);
+enum validationMode sudokuGetValidationMode(void);
+void sudokuSetFastFail(bool enabled);
+// cache verdicts/solutions keyed by a hash of the grid, for repeat-heavy
+// workloads; exact repeats then skip validation and solving entirely
+void sudokuSetResultCache(bool enabled);
+
+// dispatches between the fused kernel and the persistent worker pool
+void checkPuzzle(int psize, int **grid, bool *complete, bool *valid);
+// fused single-pass kernel, psize <= 64
+void checkPuzzleFused(int psize, int **grid, bool *complete, bool *valid);
+
+/* ---- solving ---- */
+
+// fills transitively forced cells only (incremental masks + worklist)
+void solveMissingNumber(int **grid, int psize);
+// full propagation + backtracking search, psize <= 64
+bool solvePuzzle(int psize, int **grid);
+// same contract, but subtrees race on the worker pool with cancellation;
+// must not be called from a pool worker
+bool solvePuzzleParallel(int psize, int **grid);
+
+// solvePuzzle that snapshots grid + search stack to checkpointPath every
+// intervalSeconds and resumes from a matching snapshot on startup
+bool solvePuzzleCheckpointed(int psize, int **grid, const char *checkpointPath,
+                             double intervalSeconds);
+
+// count solutions with early cutoff: returns min(count, limit), so
+// uniqueness checks pass limit = 2 and never pay for full enumeration.
+// The caller's grid is left untouched
+int countSudokuSolutions(int psize, int **grid, int limit);
+// subtrees counted across the worker pool; not from a pool worker
+int countSudokuSolutionsParallel(int psize, int **grid, int limit);
+
+// cheap O(psize^2) difficulty pre-pass; ordered easiest to hardest so
+// schedulers can compare tiers directly
+enum puzzleDifficulty {
+    PUZZLE_COMPLETE,      // no empty cells
+    PUZZLE_SINGLES_ONLY,  // every empty cell has exactly one candidate
+    PUZZLE_SEARCH_NEEDED
+};
+
+enum puzzleDifficulty classifyPuzzle(int psize, int **grid);
+// classifier-routed solve: fused check / propagation only / full search
+bool solvePuzzleAuto(int psize, int **grid);
+
+/* ---- reusable solver context for embedding ---- */
+
+// Owns the grid buffer and all candidate-mask scratch for one puzzle size,
+// so repeated validate/solve calls perform no allocation at all.
+typedef struct sudokuContext sudokuContext;
+
+sudokuContext *sudokuContextCreate(int psize);
+void sudokuContextDestroy(sudokuContext *ctx);
+
+// the context's grid, for callers to fill in place (1-based indexing)
+int **sudokuContextGrid(sudokuContext *ctx);
+int sudokuContextSize(sudokuContext *ctx);
+
+// rescans only units written since the last call (via setCell, a solve, or
+// MarkDirty); clean units answer from cached per-unit verdict bits
+void sudokuContextValidate(sudokuContext *ctx, bool *complete, bool *valid);
+bool sudokuContextSolve(sudokuContext *ctx);
+// flag a directly-written cell's row/column/box for rescan
+void sudokuContextMarkDirty(sudokuContext *ctx, int row, int col);
+
+// Incremental revalidation for single-cell edits: setCell writes one cell
+// and adjusts cached per-unit counts; Verdict then answers in O(1) instead
+// of a full board scan. First use seeds the counts with one full pass.
+void sudokuContextSetCell(sudokuContext *ctx, int row, int col, int val);
+void sudokuContextVerdict(sudokuContext *ctx, bool *complete, bool *valid);
+
+/* ---- batch drivers ---- */
+
+int runBatch(char *filename);
+int runBatchParallel(char *filename);
+// stdin pipeline: reader thread parses ahead, pool validates, verdicts
+// drain in input order from the calling thread
+int runStream(void);
+
+/* ---- process-wide setup / reporting ---- */
+
+// resolves SIMD scan kernels once; scalar fallbacks apply if never called
+void initScanKernels(void);
+// pin pool workers across NUMA nodes with per-node task rings and grid
+// freelists; call before the first pool use. No-op on single-node machines
+void sudokuSetNumaAware(bool enabled);
+// size the worker pool to `workers` threads; 0 restores the default of one
+// per online CPU. A live (idle) pool is rebuilt at the new size on next use
+void sudokuSetWorkerCount(int workers);
+// dumps the --stats instrumentation counters (no-op under SUDOKU_NO_STATS)
+void printStats(void);
+
+#endif /* SUDOKU_H */